@@ -33,6 +33,16 @@ static DLXNode root;         // Root node of the Dancing Links structure
 // We'll collect the final solution row indices here.
 static vector<int> solutionRows;
 
+// State of a suspended enumeration: one frame per search depth, holding the
+// column chosen at that depth and the row currently being tried in it.
+struct SearchFrame {
+    Column* col;
+    DLXNode* row;
+};
+static vector<SearchFrame> searchStack;
+static bool enumStarted = false;   // true once the first solution was returned
+static bool enumExhausted = false; // true once the whole tree was explored
+
 // Forward declarations
 static bool searchDLX(int depth);
 
@@ -130,8 +140,89 @@ static Column& chooseColumn() {
     return *best;
 }
 
+// ------------------------------------------------------------------
+// Search-tree tracing (build with -DDLX_TRACE)
+// ------------------------------------------------------------------
+
+// One record per row tried by searchDLX, stored in the order the search
+// visits them (preorder), so the tree can be rebuilt from the depths alone.
+struct TraceRecord {
+    uint32_t subtreeNodes; // searchDLX calls made while this row was tried
+    uint16_t colIndex;     // column chosen at this search node
+    uint16_t rowIndex;     // encoded (r, c, d) being tried
+    uint8_t depth;
+    uint8_t colSize;       // size of the chosen column => branching factor
+};
+
+// Header of a trace file; the records follow it as raw TraceRecords.
+struct TraceHeader {
+    char magic[4];         // "DLXT"
+    uint32_t recordCount;
+    uint64_t droppedRecords; // rows tried after the buffer was full
+    uint64_t totalNodes;     // searchDLX calls in the whole run
+};
+
+#ifdef DLX_TRACE
+// Bounded buffer: once it is full, further records are only counted.
+#ifndef DLX_TRACE_CAPACITY
+#define DLX_TRACE_CAPACITY (1 << 20)
+#endif
+static TraceRecord traceBuf[DLX_TRACE_CAPACITY];
+static uint32_t traceCount = 0;
+static uint64_t traceDropped = 0;
+static uint64_t traceNodes = 0;
+
+static void resetTrace() {
+    traceCount = 0;
+    traceDropped = 0;
+    traceNodes = 0;
+}
+
+// Reserve a record for a row about to be tried; -1 if the buffer is full
+static inline int64_t traceBegin(int depth, const Column &col, const DLXNode* rowNode) {
+    if (traceCount == DLX_TRACE_CAPACITY) {
+        traceDropped++;
+        return -1;
+    }
+    TraceRecord &rec = traceBuf[traceCount];
+    rec.subtreeNodes = 0;
+    rec.colIndex = (uint16_t)col.head.colIndex;
+    rec.rowIndex = (uint16_t)rowNode->rowIndex;
+    rec.depth = (uint8_t)depth;
+    rec.colSize = (uint8_t)col.size;
+    return traceCount++;
+}
+
+// Fill in the subtree size once the recursive call has returned
+static inline void traceEnd(int64_t slot, uint64_t nodesBefore) {
+    if (slot >= 0) traceBuf[slot].subtreeNodes = (uint32_t)(traceNodes - nodesBefore);
+}
+
+// Write the trace buffer to a compact binary file
+static bool saveTrace(const string &path) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    TraceHeader hdr = {{'D', 'L', 'X', 'T'}, traceCount, traceDropped, traceNodes};
+    bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+              fwrite(traceBuf, sizeof(TraceRecord), traceCount, f) == traceCount;
+    return fclose(f) == 0 && ok;
+}
+
+#define DLX_TRACE_NODE() (traceNodes++)
+#define DLX_TRACE_BEGIN(depth, col, rowNode) \
+    int64_t traceSlot = traceBegin(depth, col, rowNode); \
+    uint64_t traceStart = traceNodes
+#define DLX_TRACE_END() traceEnd(traceSlot, traceStart)
+#else
+// Tracing disabled => the hooks compile to nothing
+#define DLX_TRACE_NODE() ((void)0)
+#define DLX_TRACE_BEGIN(depth, col, rowNode) ((void)0)
+#define DLX_TRACE_END() ((void)0)
+#endif
+
 // Algorithm X search
 static bool searchDLX(int depth) {
+    DLX_TRACE_NODE();
     // If there are no columns left, we found a solution
     if (root.R == &root) {
         return true;
@@ -149,6 +240,7 @@ static bool searchDLX(int depth) {
     for (DLXNode* rowNode = col.head.D; rowNode != &col.head; rowNode = rowNode->D) {
         // rowNode->rowIndex is an encoded (r, c, d)
         solutionRows.push_back(rowNode->rowIndex);
+        DLX_TRACE_BEGIN(depth, col, rowNode);
 
         // Cover all columns in this row
         for (DLXNode* node = rowNode->R; node != rowNode; node = node->R) {
@@ -156,7 +248,9 @@ static bool searchDLX(int depth) {
         }
 
         // Recurse
-        if (searchDLX(depth + 1)) {
+        bool found = searchDLX(depth + 1);
+        DLX_TRACE_END();
+        if (found) {
             return true;
         }
 
@@ -172,6 +266,79 @@ static bool searchDLX(int depth) {
     return false;
 }
 
+// ------------------------------------------------------------------
+// Lazy enumeration of all solutions
+// ------------------------------------------------------------------
+
+// Cover / uncover every other column used by a row
+static void coverRow(DLXNode* rowNode) {
+    for (DLXNode* node = rowNode->R; node != rowNode; node = node->R) {
+        cover(cols[node->colIndex]);
+    }
+}
+
+static void uncoverRow(DLXNode* rowNode) {
+    for (DLXNode* node = rowNode->L; node != rowNode; node = node->L) {
+        uncover(cols[node->colIndex]);
+    }
+}
+
+// Iterative version of searchDLX that can be suspended at each solution.
+// The recursion is kept in searchStack, so the next call picks up exactly
+// where the previous one stopped. Returns true with solutionRows holding the
+// next solution, or false once every solution has been produced.
+static bool resumeSearchDLX() {
+    if (enumExhausted) return false;
+
+    // After a solution we must first move past the row that completed it
+    bool backtrack = enumStarted;
+    enumStarted = true;
+
+    while (true) {
+        if (!backtrack) {
+            // If there are no columns left, we found a solution
+            if (root.R == &root) {
+                return true;
+            }
+            Column &col = chooseColumn();
+            if (col.size == 0) {
+                // Dead end => try the next row one level up
+                backtrack = true;
+                continue;
+            }
+            // Descend: cover the column and try its first row
+            cover(col);
+            DLXNode* rowNode = col.head.D;
+            searchStack.push_back({&col, rowNode});
+            solutionRows.push_back(rowNode->rowIndex);
+            coverRow(rowNode);
+            continue;
+        }
+
+        if (searchStack.empty()) {
+            // Every branch of the root has been explored
+            enumExhausted = true;
+            return false;
+        }
+
+        // Undo the current row of the deepest frame and move to the next one
+        SearchFrame &frame = searchStack.back();
+        uncoverRow(frame.row);
+        solutionRows.pop_back();
+        frame.row = frame.row->D;
+
+        if (frame.row == &frame.col->head) {
+            // No rows left in this column => pop the frame
+            uncover(*frame.col);
+            searchStack.pop_back();
+            continue;
+        }
+        solutionRows.push_back(frame.row->rowIndex);
+        coverRow(frame.row);
+        backtrack = false;
+    }
+}
+
 // ------------------------------------------------------------------
 // Build the matrix
 // ------------------------------------------------------------------
@@ -258,11 +425,10 @@ static void fillSolution(int board[N][N]) {
     }
 }
 
-// Solve Sudoku with DLX
-bool solveSudokuDLX(int board[N][N]) {
-    // 1) Build rowDefs
+// Build one row definition per candidate (r, c, d) allowed by the board
+static void buildRowDefs(const int board[N][N], vector<array<int,5>> &rowDefs) {
     // We need up to 9 candidates per empty cell, or 1 if cell is given
-    vector<array<int,5>> rowDefs; 
+    rowDefs.clear();
     rowDefs.reserve(9 * N * N);  // up to 729
 
     for (int r = 0; r < N; r++) {
@@ -286,6 +452,13 @@ bool solveSudokuDLX(int board[N][N]) {
             }
         }
     }
+}
+
+// Solve Sudoku with DLX
+bool solveSudokuDLX(int board[N][N]) {
+    // 1) Build rowDefs
+    vector<array<int,5>> rowDefs;
+    buildRowDefs(board, rowDefs);
 
     // 2) Build the DLX structure
     buildDLX(rowDefs);
@@ -302,6 +475,150 @@ bool solveSudokuDLX(int board[N][N]) {
     return false;
 }
 
+// Start enumerating every solution of the puzzle. Solutions are then pulled
+// one at a time with nextSolutionDLX(); only one enumeration can be active
+// at a time since the matrix lives in static storage.
+void beginSolutionsDLX(const int board[N][N]) {
+    vector<array<int,5>> rowDefs;
+    buildRowDefs(board, rowDefs);
+    buildDLX(rowDefs);
+
+    solutionRows.clear();
+    solutionRows.reserve(N * N);
+    searchStack.clear();
+    searchStack.reserve(N * N);  // at most one frame per cell
+    enumStarted = false;
+    enumExhausted = false;
+}
+
+// Resume the suspended search and write the next solution into board.
+// Returns false once all solutions have been produced.
+bool nextSolutionDLX(int board[N][N]) {
+    if (!resumeSearchDLX()) return false;
+    fillSolution(board);
+    return true;
+}
+
+// Count-only mode: walks the same search but never builds a board.
+long long countSolutionsDLX(const int board[N][N]) {
+    beginSolutionsDLX(board);
+    long long count = 0;
+    while (resumeSearchDLX()) {
+        count++;
+    }
+    return count;
+}
+
+// ------------------------------------------------------------------
+// Trace conversion (works on trace files from any build)
+// ------------------------------------------------------------------
+
+// Read a binary trace written by saveTrace()
+static bool loadTrace(const string &path, TraceHeader &hdr, vector<TraceRecord> &records) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    bool ok = fread(&hdr, sizeof(hdr), 1, f) == 1 && memcmp(hdr.magic, "DLXT", 4) == 0;
+    if (ok) {
+        records.resize(hdr.recordCount);
+        ok = fread(records.data(), sizeof(TraceRecord), records.size(), f) == records.size();
+    }
+    fclose(f);
+    return ok;
+}
+
+// Frame name for a row tried: cell, digit and size of the chosen column,
+// e.g. "r3c7=5/2" (1-based row, column and digit)
+static string traceFrameName(const TraceRecord &rec) {
+    int d = rec.rowIndex % 9;
+    int tmp = rec.rowIndex / 9;
+    int c = tmp % 9;
+    int r = tmp / 9;
+    return "r" + to_string(r + 1) + "c" + to_string(c + 1) + "=" + to_string(d + 1) +
+           "/" + to_string(rec.colSize);
+}
+
+// Emit folded stacks ("frame;frame;... count") for flamegraph.pl. Each line
+// is weighted by the search nodes spent in that row itself, i.e. its
+// subtree minus the subtrees of its children.
+static void writeFoldedStacks(const TraceHeader &hdr, const vector<TraceRecord> &records, ostream &out) {
+    struct OpenFrame {
+        string path;
+        uint64_t subtree;
+        uint64_t childNodes;
+    };
+    vector<OpenFrame> open;
+    uint64_t topLevelNodes = 0;
+
+    auto closeFrame = [&]() {
+        OpenFrame &f = open.back();
+        out << f.path << " " << f.subtree - f.childNodes << "\n";
+        open.pop_back();
+    };
+
+    for (const TraceRecord &rec : records) {
+        // Records are in preorder => close every frame at this depth or deeper
+        while (open.size() > rec.depth) closeFrame();
+
+        string path = open.empty() ? "searchDLX" : open.back().path;
+        path += ";" + traceFrameName(rec);
+        if (open.empty()) topLevelNodes += rec.subtreeNodes;
+        else open.back().childNodes += rec.subtreeNodes;
+        open.push_back({path, rec.subtreeNodes, 0});
+    }
+    while (!open.empty()) closeFrame();
+
+    // The root call plus any nodes not covered by a recorded row
+    if (hdr.totalNodes > topLevelNodes) {
+        out << "searchDLX " << hdr.totalNodes - topLevelNodes << "\n";
+    }
+}
+
+// Per-depth branching summary: how many search nodes branched at each
+// depth, how wide they were and how much of the tree hangs below them.
+static void writeDepthSummary(const TraceHeader &hdr, const vector<TraceRecord> &records, ostream &out) {
+    struct DepthStats {
+        uint64_t nodes = 0;      // search nodes that tried at least one row
+        uint64_t rows = 0;       // rows tried
+        uint64_t sizeSum = 0;    // sum of chosen column sizes over nodes
+        uint64_t forced = 0;     // nodes whose column had a single row
+        uint64_t subtree = 0;    // search nodes below this depth
+    };
+    vector<DepthStats> stats;
+    vector<bool> inNode; // true while the rows of one node at that depth are being listed
+
+    for (const TraceRecord &rec : records) {
+        size_t depth = rec.depth;
+        if (stats.size() <= depth) {
+            stats.resize(depth + 1);
+            inNode.resize(depth + 1, false);
+        }
+        // A shallower record means every deeper node has been finished
+        for (size_t d = depth + 1; d < inNode.size(); d++) inNode[d] = false;
+
+        DepthStats &st = stats[depth];
+        if (!inNode[depth]) {
+            // First row of a new search node at this depth
+            inNode[depth] = true;
+            st.nodes++;
+            st.sizeSum += rec.colSize;
+            if (rec.colSize == 1) st.forced++;
+        }
+        st.rows++;
+        st.subtree += rec.subtreeNodes;
+    }
+
+    out << "# " << records.size() << " records, " << hdr.droppedRecords << " dropped, "
+        << hdr.totalNodes << " search nodes\n";
+    out << "depth  nodes  rows  avg_size  forced  subtree_nodes\n";
+    for (size_t d = 0; d < stats.size(); d++) {
+        const DepthStats &st = stats[d];
+        double avgSize = st.nodes ? double(st.sizeSum) / st.nodes : 0.0;
+        out << setw(5) << d << " " << setw(6) << st.nodes << " " << setw(5) << st.rows << " "
+            << setw(9) << fixed << setprecision(2) << avgSize << " " << setw(7) << st.forced << " "
+            << setw(14) << st.subtree << "\n";
+    }
+}
+
 // Utility function to print Sudoku board
 static void printBoard(int board[N][N]) {
     for (int r = 0; r < N; r++) {
@@ -317,11 +634,60 @@ static void printBoard(int board[N][N]) {
     }
 }
 
+// Parse an 81-character puzzle string; '0' or '.' marks an empty cell
+static bool parsePuzzle(const string &text, int board[N][N]) {
+    if (text.size() != N * N) return false;
+    for (int i = 0; i < N * N; i++) {
+        char ch = text[i];
+        if (ch == '.' || ch == '0') board[i / N][i % N] = 0;
+        else if (ch >= '1' && ch <= '9') board[i / N][i % N] = ch - '0';
+        else return false;
+    }
+    return true;
+}
+
+// Report throughput of an enumeration run in solutions/s
+static void printThroughput(ostream &out, long long count, chrono::steady_clock::time_point start) {
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    out << count << " solution(s) in " << fixed << setprecision(3) << secs << " s";
+    if (secs > 0) out << " (" << setprecision(0) << count / secs << " solutions/s)";
+    out << "\n";
+}
+
+// Stream every solution as one 81-character line; memory use stays constant
+// no matter how many solutions there are.
+static long long streamSolutions(const int puzzle[N][N], ostream &out) {
+    int board[N][N];
+    char line[N * N + 1];
+    line[N * N] = '\n';
+    long long count = 0;
+
+    beginSolutionsDLX(puzzle);
+    while (nextSolutionDLX(board)) {
+        for (int i = 0; i < N * N; i++) {
+            line[i] = char('0' + board[i / N][i % N]);
+        }
+        out.write(line, sizeof(line));
+        count++;
+    }
+    return count;
+}
+
 // ------------------------------------------------------------------
 // Main with your puzzle
 // ------------------------------------------------------------------
 
-int main() {
+// Usage:
+//   dancing_links                    solve the built-in puzzle
+//   dancing_links --all [PUZZLE]     stream every solution to stdout
+//   dancing_links --count [PUZZLE]   count solutions without building boards
+//   dancing_links --fold TRACE       convert a trace to folded stacks
+//   dancing_links --depths TRACE     per-depth branching summary of a trace
+//   dancing_links --trace TRACE [PUZZLE]
+//                                    solve and record the search tree
+//                                    (only in builds with -DDLX_TRACE)
+// PUZZLE is 81 characters, row by row, with '0' or '.' for empty cells.
+int main(int argc, char* argv[]) {
     // Puzzle from your example (bitmask solver finishes in near-zero time):
     //  8 . . | 5 3 2 | 7 . .
     //  6 . 2 | . 9 8 | . . 4
@@ -349,6 +715,61 @@ int main() {
         {0, 0, 4, 2, 7, 1, 0, 0, 8}
     };
 
+    string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--all" || mode == "--count") {
+        if (argc > 2 && !parsePuzzle(argv[2], board)) {
+            cerr << "Invalid puzzle: expected 81 characters of 1-9, 0 or '.'\n";
+            return 1;
+        }
+        auto start = chrono::steady_clock::now();
+        if (mode == "--all") {
+            ios::sync_with_stdio(false);
+            long long count = streamSolutions(board, cout);
+            cout.flush();
+            printThroughput(cerr, count, start);
+        } else {
+            long long count = countSolutionsDLX(board);
+            printThroughput(cout, count, start);
+        }
+        return 0;
+    } else if ((mode == "--fold" || mode == "--depths") && argc > 2) {
+        TraceHeader hdr;
+        vector<TraceRecord> records;
+        if (!loadTrace(argv[2], hdr, records)) {
+            cerr << "Cannot read trace file " << argv[2] << "\n";
+            return 1;
+        }
+        if (hdr.droppedRecords > 0) {
+            cerr << "Warning: trace buffer overflowed, " << hdr.droppedRecords << " records dropped\n";
+        }
+        if (mode == "--fold") writeFoldedStacks(hdr, records, cout);
+        else writeDepthSummary(hdr, records, cout);
+        return 0;
+#ifdef DLX_TRACE
+    } else if (mode == "--trace" && argc > 2) {
+        if (argc > 3 && !parsePuzzle(argv[3], board)) {
+            cerr << "Invalid puzzle: expected 81 characters of 1-9, 0 or '.'\n";
+            return 1;
+        }
+        resetTrace();
+        bool solved = solveSudokuDLX(board);
+        if (!saveTrace(argv[2])) {
+            cerr << "Cannot write trace file " << argv[2] << "\n";
+            return 1;
+        }
+        cout << (solved ? "Solved" : "No solution") << ", " << traceNodes << " search nodes, "
+             << traceCount << " records (" << traceDropped << " dropped) written to " << argv[2] << "\n";
+        return 0;
+#endif
+    } else if (!mode.empty()) {
+        cerr << "Usage: " << argv[0] << " [--all|--count] [PUZZLE]\n"
+             << "       " << argv[0] << " [--fold|--depths] TRACE\n";
+#ifdef DLX_TRACE
+        cerr << "       " << argv[0] << " --trace TRACE [PUZZLE]\n";
+#endif
+        return 1;
+    }
+
     cout << "Initial Sudoku Puzzle:\n";
     printBoard(board);
 